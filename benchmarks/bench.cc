@@ -0,0 +1,322 @@
+/**
+ * @file bench.cc
+ * @brief 微基准测试框架实现
+ * @author beanljun
+ * @date 2024-11-19
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace bench {
+
+namespace {
+
+struct Entry {
+    std::string          name;
+    Func                 func;
+    std::vector<int64_t> args;
+};
+
+/// 静态初始化顺序不确定，注册表在第一次使用时创建
+std::vector<Entry>& GetEntries() {
+    static std::vector<Entry>* s_entries = new std::vector<Entry>;
+    return *s_entries;
+}
+
+uint64_t NowNS() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+struct Options {
+    std::string filter;
+    double      minTime = 0.2;
+    int         repetitions = 3;
+    std::string out;
+    std::string baseline;
+    double      threshold = 10;
+    bool        list = false;
+};
+
+struct Result {
+    std::string name;
+    uint64_t    iterations = 0;
+    /// 每次重复的每操作耗时，已排序
+    std::vector<double> nsPerOp;
+    double              itemsPerSecond = 0;
+    double              bytesPerSecond = 0;
+
+    double median() const {
+        return nsPerOp[nsPerOp.size() / 2];
+    }
+};
+
+void Usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --filter=STR       only run benchmarks whose name contains STR\n"
+            "  --min_time=SEC     minimum time of one repetition, default 0.2\n"
+            "  --repetitions=N    repetitions per benchmark, median is reported, default 3\n"
+            "  --out=PATH         write JSON to PATH instead of stdout\n"
+            "  --baseline=PATH    compare with a previous JSON result\n"
+            "  --threshold=PCT    slowdown against baseline treated as regression, default 10\n"
+            "  --list             list benchmark names\n",
+            prog);
+}
+
+bool ParseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t      pos = arg.find('=');
+        std::string key = arg.substr(0, pos);
+        std::string value = pos == std::string::npos ? "" : arg.substr(pos + 1);
+        if (key == "--filter") {
+            opt.filter = value;
+        } else if (key == "--min_time") {
+            opt.minTime = atof(value.c_str());
+        } else if (key == "--repetitions") {
+            opt.repetitions = std::max(1, atoi(value.c_str()));
+        } else if (key == "--out") {
+            opt.out = value;
+        } else if (key == "--baseline") {
+            opt.baseline = value;
+        } else if (key == "--threshold") {
+            opt.threshold = atof(value.c_str());
+        } else if (key == "--list") {
+            opt.list = true;
+        } else {
+            Usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// 运行一次，返回状态
+State RunOnce(Func func, uint64_t iterations, int64_t arg) {
+    State state(iterations, arg);
+    func(state);
+    state.stopTimer();
+    return state;
+}
+
+Result Run(const std::string& name, Func func, int64_t arg, const Options& opt) {
+    uint64_t min_ns = (uint64_t)(opt.minTime * 1e9);
+    uint64_t iterations = 1;
+    // 逐步放大次数，每次最多放大10倍，直到一次运行超过min_time
+    while (true) {
+        State    state = RunOnce(func, iterations, arg);
+        uint64_t elapsed = std::max<uint64_t>(state.getElapsedNS(), 1);
+        if (elapsed >= min_ns || iterations >= 1000000000ull)
+            break;
+        double scale = std::min(10.0, std::max(1.5, min_ns * 1.2 / elapsed));
+        iterations = (uint64_t)(iterations * scale) + 1;
+    }
+
+    Result rt;
+    rt.name = name;
+    rt.iterations = iterations;
+    std::vector<double> items_rate;
+    std::vector<double> bytes_rate;
+    for (int i = 0; i < opt.repetitions; ++i) {
+        State  state = RunOnce(func, iterations, arg);
+        double ns = (double)std::max<uint64_t>(state.getElapsedNS(), 1);
+        rt.nsPerOp.push_back(ns / iterations);
+        items_rate.push_back(state.getItems() * 1e9 / ns);
+        bytes_rate.push_back(state.getBytes() * 1e9 / ns);
+    }
+    std::sort(rt.nsPerOp.begin(), rt.nsPerOp.end());
+    std::sort(items_rate.begin(), items_rate.end());
+    std::sort(bytes_rate.begin(), bytes_rate.end());
+    rt.itemsPerSecond = items_rate[items_rate.size() / 2];
+    rt.bytesPerSecond = bytes_rate[bytes_rate.size() / 2];
+    return rt;
+}
+
+std::string Escape(const std::string& v) {
+    std::string rt;
+    for (char c : v) {
+        if (c == '"' || c == '\\')
+            rt.push_back('\\');
+        if ((unsigned char)c >= 0x20)
+            rt.push_back(c);
+    }
+    return rt;
+}
+
+/// 每个基准占一行，--baseline按行读取
+std::string ToJson(const std::vector<Result>& results) {
+    char hostname[256] = {0};
+    gethostname(hostname, sizeof(hostname) - 1);
+    char      date[64];
+    time_t    now = time(0);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", &tm);
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\n\"context\":{\"date\":\"" << date << "\",\"host\":\"" << Escape(hostname)
+       << "\",\"cpus\":" << sysconf(_SC_NPROCESSORS_ONLN) << ",\"lock_profile\":"
+#ifdef SYLAR_LOCK_PROFILE
+       << "true"
+#else
+       << "false"
+#endif
+       << ",\"fiber_ucontext\":"
+#ifdef SYLAR_FIBER_USE_UCONTEXT
+       << "true"
+#else
+       << "false"
+#endif
+       << "},\n\"benchmarks\":[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        ss << (i ? ",\n" : "\n") << "{\"name\":\"" << Escape(r.name) << "\",\"iterations\":" << r.iterations
+           << ",\"repetitions\":" << r.nsPerOp.size() << ",\"ns_per_op\":" << r.median()
+           << ",\"ns_per_op_min\":" << r.nsPerOp.front() << ",\"ns_per_op_max\":" << r.nsPerOp.back()
+           << ",\"items_per_second\":" << r.itemsPerSecond;
+        if (r.bytesPerSecond > 0)
+            ss << ",\"bytes_per_second\":" << r.bytesPerSecond;
+        ss << "}";
+    }
+    ss << "\n]}\n";
+    return ss.str();
+}
+
+/// 从之前输出的JSON中读取每个基准的ns_per_op
+bool LoadBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream ifs(path);
+    if (!ifs)
+        return false;
+    static const std::string kName = "\"name\":\"";
+    static const std::string kNs = "\"ns_per_op\":";
+    std::string line;
+    while (std::getline(ifs, line)) {
+        size_t name_pos = line.find(kName);
+        size_t ns_pos = line.find(kNs);
+        if (name_pos == std::string::npos || ns_pos == std::string::npos)
+            continue;
+        name_pos += kName.size();
+        size_t end = line.find('"', name_pos);
+        if (end == std::string::npos)
+            continue;
+        baseline[line.substr(name_pos, end - name_pos)] = atof(line.c_str() + ns_pos + kNs.size());
+    }
+    return true;
+}
+
+}  // namespace
+
+State::State(uint64_t iterations, int64_t arg)
+    : m_iterations(iterations), m_arg(arg), m_items(iterations), m_startNS(NowNS()) {}
+
+void State::resetTimer() {
+    m_startNS = NowNS();
+    m_stopNS = 0;
+}
+
+void State::stopTimer() {
+    if (!m_stopNS)
+        m_stopNS = NowNS();
+}
+
+uint64_t State::getElapsedNS() const {
+    return (m_stopNS ? m_stopNS : NowNS()) - m_startNS;
+}
+
+Registrar::Registrar(const char* name, Func func, const std::vector<int64_t>& args) {
+    GetEntries().push_back(Entry{name, func, args});
+}
+
+int RunAll(int argc, char** argv) {
+    Options opt;
+    if (!ParseOptions(argc, argv, opt))
+        return 2;
+
+    std::vector<std::pair<std::string, int64_t> > todo;
+    std::vector<Func>                             funcs;
+    for (auto& e : GetEntries()) {
+        if (e.args.empty()) {
+            todo.emplace_back(e.name, 0);
+            funcs.push_back(e.func);
+        }
+        for (int64_t a : e.args) {
+            todo.emplace_back(e.name + "/" + std::to_string(a), a);
+            funcs.push_back(e.func);
+        }
+    }
+
+    std::vector<Result> results;
+    for (size_t i = 0; i < todo.size(); ++i) {
+        if (!opt.filter.empty() && todo[i].first.find(opt.filter) == std::string::npos)
+            continue;
+        if (opt.list) {
+            printf("%s\n", todo[i].first.c_str());
+            continue;
+        }
+        results.push_back(Run(todo[i].first, funcs[i], todo[i].second, opt));
+        const Result& r = results.back();
+        // 进度和可读的结果写stderr，stdout只有JSON
+        fprintf(stderr, "%-40s %12.1f ns/op %14.0f items/s", r.name.c_str(), r.median(), r.itemsPerSecond);
+        if (r.bytesPerSecond > 0)
+            fprintf(stderr, " %10.1f MB/s", r.bytesPerSecond / 1e6);
+        fprintf(stderr, "\n");
+    }
+    if (opt.list)
+        return 0;
+
+    std::string json = ToJson(results);
+    if (opt.out.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream ofs(opt.out, std::ios::trunc);
+        ofs << json;
+        if (!ofs) {
+            fprintf(stderr, "write %s fail\n", opt.out.c_str());
+            return 2;
+        }
+    }
+
+    if (opt.baseline.empty())
+        return 0;
+    std::map<std::string, double> baseline;
+    if (!LoadBaseline(opt.baseline, baseline)) {
+        fprintf(stderr, "read baseline %s fail\n", opt.baseline.c_str());
+        return 2;
+    }
+    int regressions = 0;
+    for (auto& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0)
+            continue;
+        double change = (r.median() - it->second) * 100 / it->second;
+        if (change > opt.threshold) {
+            fprintf(stderr, "REGRESSION %-40s %.1f -> %.1f ns/op (+%.1f%%)\n", r.name.c_str(), it->second,
+                    r.median(), change);
+            ++regressions;
+        }
+    }
+    fprintf(stderr, "%d regression(s) over %.1f%%\n", regressions, opt.threshold);
+    return regressions ? 1 : 0;
+}
+
+}  // namespace bench
+
+int main(int argc, char** argv) {
+    return bench::RunAll(argc, argv);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file bench.h
+ * @brief 微基准测试框架
+ * @details 每个基准函数循环执行state.iterations()次被测操作，框架先自动增加次数直到单次运行
+ *          超过--min_time，再按这个次数重复运行--repetitions次，取每次操作耗时的中位数。
+ *          结果以JSON输出，可以用--baseline与之前的结果比较，变慢超过--threshold时返回非0
+ * @author beanljun
+ * @date 2024-11-19
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/**
+ * @brief 一次运行的状态
+ * @details 计时从调用基准函数前开始，到函数返回或stopTimer为止
+ */
+class State {
+public:
+    State(uint64_t iterations, int64_t arg);
+
+    /// 本次运行需要执行的次数
+    uint64_t iterations() const {
+        return m_iterations;
+    }
+
+    /// 注册时给出的参数，没有参数时为0
+    int64_t arg() const {
+        return m_arg;
+    }
+
+    /// 准备工作完成后调用，之前的时间不计入
+    void resetTimer();
+
+    /// 清理工作开始前调用，之后的时间不计入
+    void stopTimer();
+
+    /// 实际处理的条目数，默认等于iterations()
+    void setItemsProcessed(uint64_t v) {
+        m_items = v;
+    }
+
+    /// 实际处理的字节数，不为0时输出吞吐量
+    void setBytesProcessed(uint64_t v) {
+        m_bytes = v;
+    }
+
+    uint64_t getElapsedNS() const;
+    uint64_t getItems() const {
+        return m_items;
+    }
+    uint64_t getBytes() const {
+        return m_bytes;
+    }
+
+private:
+    uint64_t m_iterations;
+    int64_t  m_arg;
+    uint64_t m_items;
+    uint64_t m_bytes = 0;
+    uint64_t m_startNS;
+    uint64_t m_stopNS = 0;
+};
+
+typedef void (*Func)(State&);
+
+/// 注册基准函数，由SYLAR_BENCHMARK在静态初始化时调用
+struct Registrar {
+    /**
+     * @param[in] name 基准名
+     * @param[in] args 每个参数单独运行一次，结果名为name/arg，为空时只运行一次
+     */
+    Registrar(const char* name, Func func, const std::vector<int64_t>& args = std::vector<int64_t>());
+};
+
+/// 阻止编译器把被测操作的结果当作无用代码删掉
+template <class T>
+inline void DoNotOptimize(const T& v) {
+    asm volatile("" : : "r"(&v) : "memory");
+}
+
+/// 运行所有注册的基准，返回进程退出码
+int RunAll(int argc, char** argv);
+
+}  // namespace bench
+
+#define SYLAR_BENCHMARK(func) static bench::Registrar s_bench_registrar_##func(#func, func)
+
+#define SYLAR_BENCHMARK_ARGS(func, ...) \
+    static bench::Registrar s_bench_registrar_##func(#func, func, std::vector<int64_t>{__VA_ARGS__})
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * @file bench_fiber.cc
+ * @brief 协程创建与切换
+ * @author beanljun
+ * @date 2024-11-19
+ */
+
+#include "../sylar/sylar.h"
+#include "bench.h"
+
+/// 创建一个不参与调度的协程，运行到结束后销毁
+static void fiber_create(bench::State& state) {
+    sylar::Fiber::GetThis();
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        sylar::Fiber::ptr fiber(new sylar::Fiber([&sum]() { ++sum; }, 0, false));
+        fiber->resume();
+    }
+    bench::DoNotOptimize(sum);
+}
+SYLAR_BENCHMARK(fiber_create);
+
+/// 复用同一个协程，每次reset后运行到结束
+static void fiber_reset(bench::State& state) {
+    sylar::Fiber::GetThis();
+    uint64_t          sum = 0;
+    sylar::Fiber::ptr fiber(new sylar::Fiber([&sum]() { ++sum; }, 0, false));
+    fiber->resume();
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        fiber->reset([&sum]() { ++sum; });
+        fiber->resume();
+    }
+    bench::DoNotOptimize(sum);
+}
+SYLAR_BENCHMARK(fiber_reset);
+
+/// 一次resume加一次yield，即两次上下文切换
+static void fiber_switch(bench::State& state) {
+    sylar::Fiber::GetThis();
+    uint64_t          n = state.iterations();
+    sylar::Fiber::ptr fiber(new sylar::Fiber(
+        [n]() {
+            for (uint64_t i = 0; i < n; ++i) {
+                sylar::Fiber::GetThisPtr()->yield();
+            }
+        },
+        0, false));
+    state.resetTimer();
+    for (uint64_t i = 0; i < n; ++i) {
+        fiber->resume();
+    }
+    state.stopTimer();
+    fiber->resume();
+}
+SYLAR_BENCHMARK(fiber_switch);
@@ -0,0 +1,51 @@
+/**
+ * @file bench_log.cc
+ * @brief 日志格式化
+ * @author beanljun
+ * @date 2024-11-19
+ */
+
+#include <time.h>
+
+#include <string>
+
+#include "../sylar/sylar.h"
+#include "bench.h"
+
+namespace {
+
+sylar::LogEvent::ptr MakeEvent() {
+    sylar::LogEvent::ptr event(new sylar::LogEvent("root", sylar::LogLevel::INFO, __FILE__, __LINE__, 1234,
+                                                   sylar::GetThreadId(), 0, time(0), "bench"));
+    event->getSS() << "accept client fd=17 addr=127.0.0.1:52314 keepalive=1";
+    return event;
+}
+
+void RunFormatter(bench::State& state, const std::string& pattern) {
+    sylar::LogFormatter  fmt(pattern);
+    sylar::LogEvent::ptr event = MakeEvent();
+    std::string          out;
+    uint64_t             bytes = 0;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        out.clear();
+        fmt.format(out, event);
+        bytes += out.size();
+    }
+    state.stopTimer();
+    state.setBytesProcessed(bytes);
+}
+
+}  // namespace
+
+/// 默认格式，包括时间、线程、协程等全部字段
+static void log_formatter_default(bench::State& state) {
+    RunFormatter(state, "%d{%Y-%m-%d %H:%M:%S} [%rms]%T%t%T%N%T%F%T[%p]%T[%c]%T%f:%l%T%m%n");
+}
+SYLAR_BENCHMARK(log_formatter_default);
+
+/// 只有消息
+static void log_formatter_message(bench::State& state) {
+    RunFormatter(state, "%m%n");
+}
+SYLAR_BENCHMARK(log_formatter_message);
@@ -0,0 +1,49 @@
+/**
+ * @file bench_scheduler.cc
+ * @brief 调度器的任务吞吐
+ * @author beanljun
+ * @date 2024-11-19
+ */
+
+#include <atomic>
+#include <vector>
+
+#include "../sylar/sylar.h"
+#include "bench.h"
+
+/**
+ * @brief arg个生产者线程并发schedule，两个工作线程执行
+ * @details 计时从生产者开始提交到最后一个任务执行完，包括任务的调度和执行
+ */
+static void schedule_throughput(bench::State& state) {
+    int                   producers = (int)state.arg();
+    uint64_t              total = state.iterations();
+    std::atomic<uint64_t> done{0};
+    sylar::Semaphore      finished;
+    sylar::Scheduler      sc(2, false, "bench");
+    sc.start();
+
+    auto task = [&done, &finished, total]() {
+        if (done.fetch_add(1, std::memory_order_relaxed) + 1 == total)
+            finished.notify();
+    };
+    state.resetTimer();
+    std::vector<sylar::Thread::ptr> threads;
+    for (int i = 0; i < producers; ++i) {
+        uint64_t n = total / producers + (i < (int)(total % producers) ? 1 : 0);
+        threads.emplace_back(new sylar::Thread(
+            [&sc, &task, n]() {
+                for (uint64_t j = 0; j < n; ++j) {
+                    sc.schedule(task);
+                }
+            },
+            "bench_producer_" + std::to_string(i)));
+    }
+    for (auto& t : threads) {
+        t->join();
+    }
+    finished.wait();
+    state.stopTimer();
+    sc.stop();
+}
+SYLAR_BENCHMARK_ARGS(schedule_throughput, 1, 2, 4, 8);
@@ -0,0 +1,68 @@
+/**
+ * @file bench_serialization.cc
+ * @brief ByteArray的Varint编解码
+ * @author beanljun
+ * @date 2024-11-19
+ */
+
+#include <vector>
+
+#include "../sylar/sylar.h"
+#include "bench.h"
+
+namespace {
+
+static const size_t kValues = 1024;
+
+/// 编码后1到5字节的值各占一部分，固定种子保证每次运行相同
+std::vector<uint32_t> MakeValues() {
+    std::vector<uint32_t> values;
+    uint32_t              seed = 12345;
+    for (size_t i = 0; i < kValues; ++i) {
+        seed = seed * 1103515245 + 12345;
+        values.push_back(seed >> (i % 5 * 7));
+    }
+    return values;
+}
+
+}  // namespace
+
+/// 每次写入一个uint32_t，写满kValues个后clear
+static void bytearray_varint_encode(bench::State& state) {
+    std::vector<uint32_t> values = MakeValues();
+    sylar::ByteArray      ba;
+    uint64_t              bytes = 0;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        ba.writeUint32(values[i % kValues]);
+        if (i % kValues == kValues - 1) {
+            bytes += ba.getSize();
+            ba.clear();
+        }
+    }
+    state.stopTimer();
+    state.setBytesProcessed(bytes + ba.getSize());
+}
+SYLAR_BENCHMARK(bytearray_varint_encode);
+
+/// 每次读出一个uint32_t，读完kValues个后回到开头
+static void bytearray_varint_decode(bench::State& state) {
+    std::vector<uint32_t> values = MakeValues();
+    sylar::ByteArray      ba;
+    for (uint32_t v : values) {
+        ba.writeUint32(v);
+    }
+    size_t   size = ba.getSize();
+    uint64_t sum = 0;
+    ba.setPosition(0);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        sum += ba.readUint32();
+        if (i % kValues == kValues - 1)
+            ba.setPosition(0);
+    }
+    state.stopTimer();
+    bench::DoNotOptimize(sum);
+    state.setBytesProcessed(state.iterations() / kValues * size + ba.getPosition());
+}
+SYLAR_BENCHMARK(bytearray_varint_decode);
@@ -0,0 +1,43 @@
+/**
+ * @file bench_timer.cc
+ * @brief 定时器的添加与取消
+ * @author beanljun
+ * @date 2024-11-19
+ */
+
+#include <vector>
+
+#include "../sylar/sylar.h"
+#include "bench.h"
+
+namespace {
+
+/// 只用来管理定时器，不需要被唤醒
+class BenchTimerManager : public sylar::TimerManager {
+protected:
+    void onTimerInsertedAtFront() override {}
+};
+
+}  // namespace
+
+/**
+ * @brief 已有arg个定时器时添加一个定时器再取消
+ * @details 超时时间错开，避免总是插到最前面
+ */
+static void timer_add_cancel(bench::State& state) {
+    BenchTimerManager              mgr;
+    std::vector<sylar::Timer::ptr> existing;
+    for (int64_t i = 0; i < state.arg(); ++i) {
+        existing.push_back(mgr.addTimer(60000 + i % 1000, []() {}));
+    }
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        sylar::Timer::ptr timer = mgr.addTimer(1000 + i % 100000, []() {});
+        timer->cancel();
+    }
+    state.stopTimer();
+    for (auto& t : existing) {
+        t->cancel();
+    }
+}
+SYLAR_BENCHMARK_ARGS(timer_add_cancel, 0, 10000);
@@ -0,0 +1,79 @@
+/**
+ * @file bench_url.cc
+ * @brief url编解码与查询参数解析
+ * @author beanljun
+ * @date 2024-11-28
+ */
+
+#include <string>
+
+#include "../sylar/sylar.h"
+#include "bench.h"
+
+namespace {
+
+/// 参数为字符串长度，大部分是不用处理的字节，每64字节有一个需要处理的字符
+std::string MakePlain(size_t len, char special) {
+    std::string s;
+    for (size_t i = 0; i < len; ++i) {
+        s.push_back(i % 64 == 63 ? special : "abcdefghijklmnopqrstuvwxyz0123456789"[i % 36]);
+    }
+    return s;
+}
+
+}  // namespace
+
+static void url_encode(bench::State& state) {
+    std::string s = MakePlain(state.arg(), ' ');
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        std::string rt = sylar::StringUtil::UrlEncode(s);
+        bench::DoNotOptimize(rt);
+    }
+    state.stopTimer();
+    state.setBytesProcessed(state.iterations() * s.size());
+}
+SYLAR_BENCHMARK_ARGS(url_encode, 16, 256, 4096);
+
+static void url_decode(bench::State& state) {
+    std::string s = MakePlain(state.arg(), '+');
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        std::string rt = sylar::StringUtil::UrlDecode(s);
+        bench::DoNotOptimize(rt);
+    }
+    state.stopTimer();
+    state.setBytesProcessed(state.iterations() * s.size());
+}
+SYLAR_BENCHMARK_ARGS(url_decode, 16, 256, 4096);
+
+/// 解码到复用的缓冲区，不分配内存
+static void url_decode_to(bench::State& state) {
+    std::string s = MakePlain(state.arg(), '+');
+    std::string buf(s.size(), '\0');
+    size_t      n = 0;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        n += sylar::StringUtil::UrlDecodeTo(&buf[0], s.data(), s.size());
+    }
+    state.stopTimer();
+    bench::DoNotOptimize(n);
+    state.setBytesProcessed(state.iterations() * s.size());
+}
+SYLAR_BENCHMARK_ARGS(url_decode_to, 16, 256, 4096);
+
+/// 每次迭代重新设置查询串并取一个参数，包括拆分和解码所有参数
+static void http_query_params(bench::State& state) {
+    const std::string query = "fields=name%2Cavatar&lang=zh-CN&q=hello+world&page=3&size=20"
+                              "&ref=https%3A%2F%2Fwww.example.com%2Fhome&tz=Asia%2FShanghai";
+    sylar::http::HttpRequest req;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        req.setQuery(query);
+        std::string v = req.getParam("q");
+        bench::DoNotOptimize(v);
+    }
+    state.stopTimer();
+    state.setBytesProcessed(state.iterations() * query.size());
+}
+SYLAR_BENCHMARK(http_query_params);